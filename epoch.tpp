@@ -0,0 +1,117 @@
+#include "brick-epoch"
+#include "brick-malloc"
+#include "brick-unit"
+#include <thread>
+#include <vector>
+
+struct node
+{
+    static inline std::atomic< int > live = 0;
+    std::atomic< int > value;
+
+    node( int v ) : value( v ) { ++ live; }
+    ~node() { value = -1; -- live; }
+};
+
+int main()
+{
+    namespace epoch = brq::epoch;
+
+    brq::test_case( "deferred" ) = []
+    {
+        auto n = new node( 1 );
+
+        {
+            epoch::guard g;
+            epoch::retire( n );
+            epoch::collect();
+            epoch::collect();
+            ASSERT_EQ( n->value.load(), 1 );
+        }
+
+        epoch::synchronize();
+        ASSERT_EQ( node::live.load(), 0 );
+    };
+
+    brq::test_case( "nested" ) = []
+    {
+        auto n = new node( 2 );
+
+        {
+            epoch::guard a;
+            {
+                epoch::guard b;
+                epoch::retire( n );
+            }
+            epoch::collect();
+            epoch::collect();
+            ASSERT_EQ( n->value.load(), 2 );
+        }
+
+        epoch::synchronize();
+        ASSERT_EQ( node::live.load(), 0 );
+    };
+
+    brq::test_case( "mm" ) = []
+    {
+        auto p = brq::malloc( 100 );
+        epoch::retire( p, brq::free );
+        epoch::synchronize();
+    };
+
+    brq::test_case( "orphans" ) = []
+    {
+        std::thread t( []{ epoch::retire( new node( 3 ) ); } );
+        t.join();
+        ASSERT_EQ( node::live.load(), 1 );
+        epoch::synchronize();
+        ASSERT_EQ( node::live.load(), 0 );
+    };
+
+    brq::test_case( "readers" ) = []
+    {
+        std::atomic< node * > shared = new node( 0 );
+        std::atomic< bool > done = false;
+        std::vector< std::thread > readers;
+
+        for ( int i = 0; i < 4; ++i )
+            readers.emplace_back( [&]
+            {
+                while ( !done )
+                {
+                    epoch::guard g;
+                    auto n = shared.load();
+                    for ( int j = 0; j < 10; ++j )
+                        ASSERT_LEQ( 0, n->value.load() );
+                }
+            } );
+
+        for ( int i = 1; i < 20000; ++i )
+            epoch::retire( shared.exchange( new node( i ) ) );
+
+        done = true;
+        for ( auto &t : readers )
+            t.join();
+
+        epoch::retire( shared.load() );
+        epoch::synchronize();
+        ASSERT_EQ( node::live.load(), 0 );
+    };
+
+    brq::test_case( "quiescent" ) = []
+    {
+        std::atomic< bool > done = false;
+        std::thread t( [&]
+        {
+            epoch::guard g;
+            while ( !done )
+                epoch::quiescent();
+        } );
+
+        epoch::retire( new node( 4 ) );
+        epoch::synchronize();
+        ASSERT_EQ( node::live.load(), 0 );
+        done = true;
+        t.join();
+    };
+}
@@ -0,0 +1,88 @@
+#include "brick-explore"
+#include "brick-string"
+#include "brick-trace"
+
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <thread>
+#include <unordered_set>
+
+/* Benchmarks for ‹brq::explore› on a synthetic graph: the states are the
+ * integers 0…N-1, each with an edge to the next one (so that everything is
+ * reachable from 0) and ‹degree - 1› more edges to pseudo-randomly chosen
+ * states, which makes for a graph with very poor locality and a wide BFS
+ * frontier, much like the state spaces of real systems. As a baseline, the
+ * graph is also explored by a plain sequential BFS with ‹std::unordered_set›.
+ * For each run, we report the throughput in states and transitions per
+ * second and the number of chunks stolen between threads.
+ *
+ * Usage: ‹explore-bench [states] [max threads] [degree]›. */
+
+using bench_clock = std::chrono::steady_clock;
+
+struct graph
+{
+    uint64_t states;
+    int degree;
+
+    void operator()( uint64_t s, auto yield ) const
+    {
+        yield( ( s + 1 ) % states );
+        for ( int i = 1; i < degree; ++i )
+            yield( ( s * 0x9e37'79b9'7f4a'7c15 + i * 0xbf58'476d'1ce4'e5b9 ) % states );
+    }
+};
+
+void report( const char *name, int threads, const brq::explore_stats &st )
+{
+    brq::string_builder b;
+    b << brq::mark << name << brq::pad( 12 ) << brq::pad( 3 ) << threads << brq::mark << " threads"
+      << brq::pad( 8 ) << int( st.states_per_second() / 1000 ) << brq::mark << " kstates/s"
+      << brq::pad( 8 ) << int( st.transitions / st.seconds / 1000 ) << brq::mark << " ktrans/s"
+      << brq::pad( 8 ) << st.steals << brq::mark << " steals";
+
+    INFO( b.data() );
+}
+
+brq::explore_stats sequential( graph g )
+{
+    brq::explore_stats st;
+    auto start = bench_clock::now();
+    std::unordered_set< uint64_t > seen{ 0 };
+    std::deque< uint64_t > queue{ 0 };
+
+    while ( !queue.empty() )
+    {
+        auto s = queue.front();
+        queue.pop_front();
+        g( s, [&]( uint64_t t )
+        {
+            ++ st.transitions;
+            if ( seen.insert( t ).second )
+                queue.push_back( t );
+        } );
+    }
+
+    st.states = seen.size();
+    st.seconds = std::chrono::duration< double >( bench_clock::now() - start ).count();
+    return st;
+}
+
+int main( int argc, const char **argv )
+{
+    uint64_t states = argc > 1 ? atoll( argv[ 1 ] ) : 4'000'000;
+    int threads = argc > 2 ? atoi( argv[ 2 ] ) : std::min( 16u, std::thread::hardware_concurrency() );
+    int degree = argc > 3 ? atoi( argv[ 3 ] ) : 4;
+    graph g{ states, degree };
+
+    report( "sequential", 1, sequential( g ) );
+
+    for ( int t = 1; t <= threads; t *= 2 )
+    {
+        auto st = brq::explore( uint64_t( 0 ), g, []( uint64_t ) {}, t );
+        if ( st.states != states )
+            ERROR( "explored", st.states, "states out of", states );
+        report( "explore", t, st );
+    }
+}
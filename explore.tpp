@@ -0,0 +1,68 @@
+#include "brick-explore"
+#include "brick-unit"
+
+/* A 2D grid, with edges going right and down (and wrapping around), encoded
+ * in a single integer. */
+
+static constexpr int width = 300, height = 200;
+
+auto grid = []( int s, auto yield )
+{
+    int x = s % width, y = s / width;
+    yield( ( x + 1 ) % width + y * width );
+    yield( x + ( ( y + 1 ) % height ) * width );
+};
+
+int main()
+{
+    brq::test_case( "single" ) = []
+    {
+        std::atomic< int > visited = 0;
+        auto st = brq::explore( 0, grid, [&]( int ) { ++ visited; }, 1 );
+        ASSERT_EQ( visited.load(), width * height );
+        ASSERT_EQ( st.states, width * height );
+        ASSERT_EQ( st.transitions, 2 * width * height );
+        ASSERT_EQ( st.queued, 0 );
+    };
+
+    brq::test_case( "parallel" ) = []
+    {
+        for ( int threads : { 2, 4, 8 } )
+        {
+            std::vector< std::atomic< int > > seen( width * height );
+            auto st = brq::explore( 0, grid, [&]( int s ) { ++ seen[ s ]; }, threads );
+
+            ASSERT_EQ( st.states, width * height );
+            for ( auto &s : seen )
+                ASSERT_EQ( s.load(), 1 );
+        }
+    };
+
+    brq::test_case( "dfs" ) = []
+    {
+        brq::explorer< int > ex;
+        ex.threads = 3;
+        ex.order = brq::search_order::dfs;
+        std::vector< int > init{ 1, 2, 1 };
+        auto st = ex.run( init.begin(), init.end(), grid, []( int ) {} );
+
+        ASSERT_EQ( st.states, width * height );
+        ASSERT( ex.visited().count( 0 ) );
+    };
+
+    brq::test_case( "stop" ) = []
+    {
+        std::atomic< int > visited = 0;
+        auto st = brq::explore( 0, grid, [&]( int s ) { ++ visited; return s != 1000; }, 4 );
+        ASSERT_LT( st.states, width * height );
+        ASSERT_EQ( visited.load(), st.states );
+    };
+
+    brq::test_case( "disconnected" ) = []
+    {
+        /* two cycles, only one of them reachable */
+        auto cycles = []( int s, auto yield ) { yield( ( s + 2 ) % 1000 ); };
+        auto st = brq::explore( std::vector{ 1, 3 }, cycles, [&]( int s ) { ASSERT_EQ( s % 2, 1 ); }, 2 );
+        ASSERT_EQ( st.states, 500 );
+    };
+}
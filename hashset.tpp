@@ -259,6 +259,49 @@ int main()
     test_sequential< hash_set, int, mm_bytealloc >();
     test_sequential< concurrent_hash_set, int, mm_bytealloc >();
 
+    test_sequential< epoch_hash_set, int, std_bytealloc >();
+    test_parallel< epoch_hash_set, int, std_bytealloc >();
+    test_sequential< epoch_hash_set, big, std_bytealloc >();
+    test_parallel< epoch_hash_set, big, std_bytealloc >();
+    test_sequential< epoch_hash_set, int, mm_bytealloc >();
+
+    brq::test_case( "epoch_reclaim" ) = []
+    {
+        brq::epoch::synchronize();
+        epoch_hash_set< int > set;
+
+        /* each growth frees the table retired by the one before */
+        for ( int i = 1; i < 16 * size; ++i )
+        {
+            set.insert( i );
+            ASSERT_LEQ( brq::epoch::thread.limbo.size(), 1u );
+        }
+    };
+
+    brq::test_case( "epoch_read_grow" ) = []
+    {
+        epoch_hash_set< int > set;
+        std::atomic< bool > done = false;
+        size_t cap = set.capacity();
+
+        /* the tables retired by the writer must outlive each read */
+        std::thread reader( [&]
+        {
+            while ( !done )
+                for ( size_t i = 0; i < cap; ++i )
+                {
+                    int v = set.valid( i ) ? set.valueAt( i ) : 0;
+                    ASSERT_LT( v, 16 * size );
+                }
+        } );
+
+        for ( int i = 1; i < 16 * size; ++i )
+            set.insert( i );
+
+        done = true;
+        reader.join();
+    };
+
 }
 
 #ifdef BRICK_BENCHMARK_REG
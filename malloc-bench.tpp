@@ -0,0 +1,400 @@
+#include "brick-malloc"
+#include "brick-string"
+#include "brick-trace"
+
+#include <algorithm>
+#include <barrier>
+#include <chrono>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+/* Benchmarks for ‹brq::malloc›, each workload run side by side with
+ * ‹std::malloc›. Every (workload, allocator) pair runs in a separate forked
+ * process, so that the memory retained by one allocator does not show up in
+ * the RSS of the other. For each run, we report throughput (allocations and
+ * frees per second, summed over all threads), the 99th percentile of
+ * per-operation latency and the resident set size at the end of the run (and
+ * its peak). Latency is only measured for every 64th operation, and includes
+ * the overhead of reading the clock twice (typically around 20–40ns). For
+ * ‹brq::malloc›, we also count transfers of free lists between the threads
+ * and the global pool, each of which involves contended atomic operations.
+ *
+ * Usage: ‹malloc-bench [filter] [threads]›, where ‹filter› is a substring of
+ * the workload name. */
+
+struct system_alloc
+{
+    static constexpr const char *name = "std::malloc";
+    static void *allocate( size_t bytes ) { return std::malloc( bytes ); }
+    static void free( void *ptr ) { std::free( ptr ); }
+    static uint64_t transfers() { return 0; }
+};
+
+struct brq_alloc
+{
+    static constexpr const char *name = "brq::malloc";
+    static void *allocate( size_t bytes ) { return brq::malloc( bytes ); }
+    static void free( void *ptr ) { brq::free( ptr ); }
+
+    static uint64_t transfers()
+    {
+        return brq::mm::thread_stats.refills + brq::mm::thread_stats.donations;
+    }
+};
+
+using bench_clock = std::chrono::steady_clock;
+
+struct stats
+{
+    uint64_t ops = 0, transfers = 0;
+    std::vector< uint32_t > latency;
+
+    template< typename op_t >
+    [[gnu::always_inline]] auto timed( op_t op )
+    {
+        if ( ++ops % 64 ) [[likely]]
+            return op();
+
+        auto start = bench_clock::now();
+        auto done  = [&]
+        {
+            auto ns = std::chrono::nanoseconds( bench_clock::now() - start ).count();
+            latency.push_back( ns );
+        };
+
+        if constexpr ( std::is_void_v< decltype( op() ) > )
+            return op(), done();
+        else
+        {
+            auto r = op();
+            done();
+            return r;
+        }
+    }
+
+    void merge( const stats &o )
+    {
+        ops += o.ops;
+        transfers += o.transfers;
+        latency.insert( latency.end(), o.latency.begin(), o.latency.end() );
+    }
+
+    uint32_t p99()
+    {
+        if ( latency.empty() )
+            return 0;
+
+        auto nth = latency.begin() + latency.size() * 99 / 100;
+        std::nth_element( latency.begin(), nth, latency.end() );
+        return *nth;
+    }
+};
+
+template< typename alloc >
+void *allocate( stats &s, size_t bytes )
+{
+    auto ptr = s.timed( [&] { return alloc::allocate( bytes ); } );
+    *static_cast< volatile char * >( ptr ) = 1; /* make sure the memory is touched */
+    return ptr;
+}
+
+template< typename alloc >
+void release( stats &s, void *ptr )
+{
+    s.timed( [&] { alloc::free( ptr ); } );
+}
+
+/* Run ‹work› in ‹count› threads, each with its own ‹stats›, and merge them. */
+
+template< typename alloc, typename work_t >
+stats run_threads( int count, work_t work )
+{
+    std::vector< stats > per_thread( count );
+    std::vector< std::thread > threads;
+
+    for ( int i = 0; i < count; ++i )
+        threads.emplace_back( [&, i]
+        {
+            work( i, per_thread[ i ] );
+            per_thread[ i ].transfers = alloc::transfers();
+        } );
+
+    stats total;
+
+    for ( int i = 0; i < count; ++i )
+    {
+        threads[ i ].join();
+        total.merge( per_thread[ i ] );
+    }
+
+    return total;
+}
+
+/* Single-threaded churn within one size group: allocate a batch of objects,
+ * then free them in random order. The number of operations is scaled down
+ * for bigger objects, so that each run moves roughly the same amount of
+ * memory. */
+
+template< typename alloc >
+stats churn( size_t bytes, int )
+{
+    stats s;
+    std::mt19937 rand;
+    std::vector< void * > batch( 1024 );
+    int rounds = std::clamp( int( ( 4ull << 30 ) / ( bytes * batch.size() ) ), 4, 2048 );
+
+    for ( int r = 0; r < rounds; ++r )
+    {
+        for ( auto &ptr : batch )
+            ptr = allocate< alloc >( s, bytes );
+
+        std::shuffle( batch.begin(), batch.end(), rand );
+
+        for ( auto ptr : batch )
+            release< alloc >( s, ptr );
+    }
+
+    return s;
+}
+
+/* A minimal single-producer, single-consumer ring for passing pointers
+ * between threads, so that the benchmark does not depend on the queues in
+ * ‹brick-shmem›. */
+
+struct handoff
+{
+    static constexpr int size = 4096;
+    std::array< void *, size > ring;
+    alignas( 64 ) std::atomic< unsigned > head = 0;
+    alignas( 64 ) std::atomic< unsigned > tail = 0;
+
+    void push( void *ptr )
+    {
+        unsigned t = tail.load( std::memory_order_relaxed );
+        while ( t - head.load( std::memory_order_acquire ) == size )
+            std::this_thread::yield();
+        ring[ t % size ] = ptr;
+        tail.store( t + 1, std::memory_order_release );
+    }
+
+    void *pop()
+    {
+        unsigned h = head.load( std::memory_order_relaxed );
+        while ( h == tail.load( std::memory_order_acquire ) )
+            std::this_thread::yield();
+        void *ptr = ring[ h % size ];
+        head.store( h + 1, std::memory_order_release );
+        return ptr;
+    }
+};
+
+/* Producer/consumer pairs: each producer allocates objects of random size
+ * (16B – 1K) and hands them off to its consumer, which frees them. All
+ * memory thus migrates between threads, which is the case the two-list
+ * design in ‹free_small› is meant for. */
+
+template< typename alloc >
+stats producer_consumer( size_t, int threads )
+{
+    int pairs = std::max( threads / 2, 1 );
+    const int items = 2 * 1024 * 1024;
+    std::vector< handoff > queues( pairs );
+
+    return run_threads< alloc >( 2 * pairs, [&]( int id, stats &s )
+    {
+        auto &q = queues[ id / 2 ];
+        std::mt19937 rand( id );
+        std::uniform_int_distribution< size_t > size( 16, 1024 );
+
+        if ( id % 2 == 0 )
+            for ( int i = 0; i < items; ++i )
+                q.push( allocate< alloc >( s, size( rand ) ) );
+        else
+            for ( int i = 0; i < items; ++i )
+                release< alloc >( s, q.pop() );
+    } );
+}
+
+/* A variant of the ‘larson’ benchmark: each thread owns an array of slots and
+ * repeatedly replaces a random slot with a fresh object of random size. After
+ * each round, the slot arrays are rotated between threads, so that a good
+ * fraction of all frees happen in a thread other than the one which did the
+ * allocation. */
+
+template< typename alloc >
+stats larson( size_t, int threads )
+{
+    const int slots = 8 * 1024, rounds = 32, steps = 64 * 1024;
+    std::vector< std::vector< void * > > arrays( threads, std::vector< void * >( slots ) );
+    std::barrier sync( threads );
+
+    return run_threads< alloc >( threads, [&]( int id, stats &s )
+    {
+        std::mt19937 rand( id );
+        std::uniform_int_distribution< size_t > size( 8, 512 );
+        std::uniform_int_distribution< int > slot( 0, slots - 1 );
+
+        for ( auto &ptr : arrays[ id ] )
+            ptr = allocate< alloc >( s, size( rand ) );
+
+        sync.arrive_and_wait();
+
+        for ( int r = 0; r < rounds; ++r )
+        {
+            auto &mine = arrays[ ( id + r ) % threads ];
+
+            for ( int i = 0; i < steps; ++i )
+            {
+                auto &ptr = mine[ slot( rand ) ];
+                release< alloc >( s, ptr );
+                ptr = allocate< alloc >( s, size( rand ) );
+            }
+
+            sync.arrive_and_wait();
+        }
+
+        for ( auto ptr : arrays[ id ] )
+            release< alloc >( s, ptr );
+    } );
+}
+
+/* Fragmentation over time: fill the heap with small objects of mixed sizes,
+ * free most of them at random, then switch to a different size range. An
+ * allocator which cannot reuse the holes ends up with a much larger RSS. The
+ * last phase frees everything, to see how much memory stays resident. */
+
+template< typename alloc >
+stats fragmentation( size_t, int )
+{
+    stats s;
+    std::mt19937 rand;
+    std::vector< void * > live;
+
+    auto fill = [&]( int count, size_t min, size_t max )
+    {
+        std::uniform_int_distribution< size_t > size( min, max );
+        for ( int i = 0; i < count; ++i )
+            live.push_back( allocate< alloc >( s, size( rand ) ) );
+    };
+
+    auto thin = [&]( int keep_one_in )
+    {
+        std::shuffle( live.begin(), live.end(), rand );
+        size_t keep = live.size() / keep_one_in;
+        for ( size_t i = keep; i < live.size(); ++i )
+            release< alloc >( s, live[ i ] );
+        live.resize( keep );
+    };
+
+    for ( int phase = 0; phase < 4; ++phase )
+    {
+        fill( 1024 * 1024, 16, 256 );
+        thin( 10 );
+        fill( 64 * 1024, 1024, 8192 );
+        thin( 2 );
+    }
+
+    for ( auto ptr : live )
+        release< alloc >( s, ptr );
+
+    return s;
+}
+
+uint64_t rss_current()
+{
+    long pages = 0, resident = 0;
+
+    if ( FILE *f = fopen( "/proc/self/statm", "r" ) )
+    {
+        if ( fscanf( f, "%ld %ld", &pages, &resident ) != 2 )
+            resident = 0;
+        fclose( f );
+    }
+
+    return resident * sysconf( _SC_PAGESIZE );
+}
+
+uint64_t rss_peak()
+{
+    struct rusage ru;
+    getrusage( RUSAGE_SELF, &ru );
+    return uint64_t( ru.ru_maxrss ) * 1024;
+}
+
+using workload_t = stats (*)( size_t, int );
+
+struct workload
+{
+    std::string name;
+    size_t bytes;
+    workload_t sys, brq;
+};
+
+#define WORKLOAD( fun ) fun< system_alloc >, fun< brq_alloc >
+
+template< typename alloc >
+void run( const workload &w, workload_t fun, int threads )
+{
+    auto start = bench_clock::now();
+    auto s = fun( w.bytes, threads );
+    s.transfers += alloc::transfers();
+    double secs = std::chrono::duration< double >( bench_clock::now() - start ).count();
+
+    brq::string_builder b;
+    b << brq::mark << w.name << brq::pad( 20 ) << brq::mark << alloc::name << brq::pad( 14 )
+      << brq::pad( 8 ) << int( s.ops / secs / 1000 ) << brq::mark << " kops/s"
+      << brq::pad( 8 ) << s.p99() << brq::mark << " ns p99"
+      << brq::pad( 6 ) << rss_current() / ( 1024 * 1024 ) << brq::mark << " MiB rss"
+      << brq::pad( 6 ) << rss_peak() / ( 1024 * 1024 ) << brq::mark << " MiB peak"
+      << brq::pad( 9 ) << s.transfers << brq::mark << " transfers";
+
+    INFO( b.data() );
+}
+
+template< typename alloc >
+void fork_run( const workload &w, workload_t fun, int threads )
+{
+    if ( pid_t pid = fork(); pid == 0 )
+    {
+        run< alloc >( w, fun, threads );
+        _exit( 0 );
+    }
+    else
+    {
+        int status;
+        waitpid( pid, &status, 0 );
+        if ( !WIFEXITED( status ) || WEXITSTATUS( status ) )
+            ERROR( w.name, alloc::name, "failed" );
+    }
+}
+
+int main( int argc, const char **argv )
+{
+    std::string_view filter = argc > 1 ? argv[ 1 ] : "";
+    int threads = argc > 2 ? atoi( argv[ 2 ] ) : std::min( 8u, std::thread::hardware_concurrency() );
+
+    std::vector< workload > workloads =
+    {
+        { "churn 16B",         16,         WORKLOAD( churn ) },
+        { "churn 256B",        256,        WORKLOAD( churn ) },
+        { "churn 2K",          2048,       WORKLOAD( churn ) },
+        { "churn 16K",         16 * 1024,  WORKLOAD( churn ) },
+        { "churn 256K",        256 * 1024, WORKLOAD( churn ) },
+        { "churn 4M",          4 << 20,    WORKLOAD( churn ) },
+        { "producer/consumer", 0,          WORKLOAD( producer_consumer ) },
+        { "larson",            0,          WORKLOAD( larson ) },
+        { "fragmentation",     0,          WORKLOAD( fragmentation ) },
+    };
+
+    for ( auto &w : workloads )
+        if ( w.name.find( filter ) != std::string::npos )
+        {
+            fork_run< system_alloc >( w, w.sys, threads );
+            fork_run< brq_alloc >( w, w.brq, threads );
+        }
+}
@@ -1,6 +1,7 @@
 #include "brick-malloc"
 #include "brick-unit"
 #include <set>
+#include <thread>
 
 int main()
 {
@@ -99,4 +100,171 @@ int main()
         for ( int i = 0; i < count; ++i )
             ASSERT_EQ( *ptrs[ i ], i );
     };
+
+    brq::test_case( "big" ) = []
+    {
+        size_t bytes = 200 * 1024 * 1024;
+
+        for ( size_t align : { 16, 4096, 1024 * 1024 } )
+        {
+            char *p = static_cast< char * >( malloc_big( bytes, align ) );
+            ASSERT_EQ( reinterpret_cast< uint64_t >( p ) % align, 0 );
+            ASSERT( is_big( p ) );
+            ASSERT( !owns_small( p ) );
+            ASSERT_LEQ( bytes, usable_size_big( p ) );
+            p[ 0 ] = p[ bytes - 1 ] = 1;
+            brq::free( p );
+        }
+    };
+
+    brq::test_case( "owns" ) = []
+    {
+        int *p = brq::malloc< int >();
+        ASSERT( owns_small( p ) );
+        brq::free( p );
+
+        int local;
+        ASSERT( !owns_small( &local ) );
+        ASSERT( !owns_small( &global ) );
+    };
+
+    brq::test_case( "aligned" ) = []
+    {
+        for ( size_t align : { 1, 8, 16, 64, 256, 4096, 64 * 1024, 1024 * 1024 } )
+            for ( size_t bytes : { 1, 3, 17, 64, 100, 1000, 5000, 70000, 3000000 } )
+            {
+                void *p = brq::aligned_alloc( align, bytes );
+                ASSERT_EQ( reinterpret_cast< uint64_t >( p ) % align, 0 );
+                ASSERT_EQ( ptr< void >( p ).size(), ptr< void >( from_size( brq::align( bytes, align ) ) ).size() );
+                brq::free( p );
+            }
+
+        void *p = brq::aligned_alloc( 256 * 1024 * 1024, 10 );
+        ASSERT( is_big( p ) );
+        ASSERT_EQ( reinterpret_cast< uint64_t >( p ) % ( 256 * 1024 * 1024 ), 0 );
+        brq::free( p );
+    };
+
+    brq::test_case( "aligned spill" ) = []
+    {
+        /* With the size group blocked, the allocation spills over into a bigger
+         * one, which must still provide the requested alignment. */
+
+        for ( size_t align : { 16, 64, 4096, 64 * 1024 } )
+        {
+            std::thread t( [=]
+            {
+                size_t bytes = 5 * align;
+                ptr< void > want( from_size( bytes ) );
+                auto &global = brq::mm::global[ want.a_group() - 1 ][ want.s_group() ];
+                uint32_t free = global.free.exchange( list_end ), brk = global.brk.exchange( UINT32_MAX );
+
+                std::vector< void * > ptrs;
+                for ( int i = 0; i < 8; ++i ) /* the first object is always aligned */
+                    ptrs.push_back( brq::aligned_alloc( align, bytes ) );
+                global.free = free, global.brk = brk;
+
+                for ( void *p : ptrs )
+                {
+                    ASSERT_LT( want.size(), ptr< void >( p ).size() );
+                    ASSERT_EQ( reinterpret_cast< uint64_t >( p ) % align, 0 );
+                    brq::free( p );
+                }
+            } );
+
+            t.join();
+        }
+    };
+
+    brq::test_case( "calloc" ) = []
+    {
+        using obj = std::array< int, 300 >;
+        std::vector< obj * > ptrs;
+
+        for ( int i = 0; i < 10000; ++i )
+        {
+            auto p = static_cast< obj * >( brq::calloc( 300, sizeof( int ) ) );
+            ASSERT( std::all_of( p->begin(), p->end(), []( int x ) { return x == 0; } ) );
+            p->fill( i + 1 );
+            ptrs.push_back( p );
+
+            if ( i % 3 == 0 )
+                brq::free( ptrs[ i / 2 ] ), ptrs[ i / 2 ] = nullptr;
+        }
+
+        for ( auto p : ptrs )
+            if ( p )
+                brq::free( p );
+
+        auto p = static_cast< obj * >( brq::calloc( 300, sizeof( int ) ) );
+        ASSERT( std::all_of( p->begin(), p->end(), []( int x ) { return x == 0; } ) );
+        brq::free( p );
+    };
+
+    brq::test_case( "profile" ) = []
+    {
+        using obj = std::array< int, 64 >;
+        profile::start( 1 ); /* sample everything */
+        std::vector< obj * > ptrs;
+
+        for ( int i = 0; i < 100; ++i )
+            ptrs.push_back( brq::malloc< obj >() );
+
+        auto live = profile::snapshot();
+        profile::stop();
+
+        ASSERT_EQ( live.size(), 1 );
+        ASSERT_EQ( live[ 0 ].count, 100 );
+        ASSERT_EQ( live[ 0 ].rec.a_group, 1 );
+
+        profile::start( 1 );
+        brq::free( brq::malloc< obj >() );
+        ASSERT( profile::snapshot().empty() );
+        profile::stop();
+
+        for ( auto p : ptrs )
+            brq::free( p );
+
+        /* big objects are aligned, which must not make them collide */
+        using big = std::array< char, 64 * 1024 >;
+        std::vector< big * > bigs;
+        profile::start( 1 );
+        for ( int i = 0; i < 500; ++i )
+            bigs.push_back( brq::malloc< big >() );
+        live = profile::snapshot();
+        profile::stop();
+
+        ASSERT_EQ( live.size(), 1 );
+        ASSERT_EQ( live[ 0 ].count, 500 );
+        ASSERT_EQ( profile::state.dropped.load(), 0 );
+
+        for ( auto p : bigs )
+            brq::free( p );
+    };
+
+    brq::test_case( "thread release" ) = []
+    {
+        using obj = std::array< int, 100 >;
+        ptr< void > first;
+
+        std::thread t( [&]
+        {
+            std::vector< obj * > ptrs;
+            for ( int i = 0; i < 64; ++i )
+                ptrs.push_back( brq::malloc< obj >() );
+            first = ptr< void >( ptrs[ 0 ] );
+            for ( auto p : ptrs )
+                brq::free( p );
+
+            auto donations = thread_stats.donations;
+            thread_release();
+            auto &group = thread[ first.a_group() - 1 ][ first.s_group() ];
+            ASSERT_LT( donations, thread_stats.donations );
+            ASSERT_EQ( group.count[ 0 ] + group.count[ 1 ], 0 );
+        } );
+
+        t.join();
+        auto &global = brq::mm::global[ first.a_group() - 1 ][ first.s_group() ];
+        ASSERT( global.free.load() != list_end );
+    };
 }
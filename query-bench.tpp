@@ -0,0 +1,107 @@
+#include "brick-query"
+#include "brick-string"
+#include "brick-trace"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include <string_view>
+
+/* Benchmarks for the push-based evaluation in ‹brick::query›: each of the
+ * numeric pipelines below is summed twice, once by walking the iterators of
+ * the query (‹std::accumulate› over ‹begin()›…‹end()›, which is what all the
+ * terminal operations used to do) and once using ‹sum()›, which pushes the
+ * source elements through the fused stages. For each run, we report the
+ * throughput in millions of source elements per second. Finally, grouping
+ * into ‹std::map› (‹groupBy›) is compared with grouping into a hash table
+ * (‹hashGroupBy›) with a varying number of distinct keys.
+ *
+ * Usage: ‹query-bench [elements] [rounds]›. */
+
+using bench_clock = std::chrono::steady_clock;
+using namespace brick;
+
+void report( std::string_view name, const char *how, size_t items, double secs )
+{
+    brq::string_builder b;
+    b << brq::mark << name << brq::pad( 20 ) << brq::mark << how << brq::pad( 10 )
+      << brq::pad( 8 ) << int( items / secs / 1'000'000 ) << brq::mark << " Mitems/s";
+
+    INFO( b.data() );
+}
+
+template< typename make_t >
+void run( const char *name, size_t items, int rounds, make_t make )
+{
+    int64_t iter = 0, push = 0;
+
+    auto start = bench_clock::now();
+    for ( int i = 0; i < rounds; ++i )
+    {
+        auto q = make();
+        iter += std::accumulate( q.begin(), q.end(), int64_t( 0 ) );
+    }
+    auto mid = bench_clock::now();
+    for ( int i = 0; i < rounds; ++i )
+        push += make().sum();
+    auto end = bench_clock::now();
+
+    if ( iter != push )
+        ERROR( name, "iterator sum", iter, "differs from push sum", push );
+
+    report( name, "iterator", items * rounds, std::chrono::duration< double >( mid - start ).count() );
+    report( name, "push", items * rounds, std::chrono::duration< double >( end - mid ).count() );
+}
+
+template< typename group_t >
+void group( const char *how, const std::vector< int64_t > &vec, int64_t keys, group_t g )
+{
+    auto start = bench_clock::now();
+    auto groups = g( query::query( vec ), [=]( int64_t x ) { return ( x * 0x9e37'79b9 ) % keys; } );
+    auto secs = std::chrono::duration< double >( bench_clock::now() - start ).count();
+
+    if ( groups.size() != std::min< int64_t >( keys, vec.size() ) )
+        ERROR( how, "produced", groups.size(), "groups instead of", keys );
+
+    brq::string_builder name;
+    name << "group/" << keys;
+    report( name.data(), how, vec.size(), secs );
+}
+
+int main( int argc, const char **argv )
+{
+    size_t items = argc > 1 ? atoll( argv[ 1 ] ) : 10'000'000;
+    int rounds = argc > 2 ? atoi( argv[ 2 ] ) : 10;
+
+    std::vector< int64_t > vec( items );
+    std::iota( vec.begin(), vec.end(), 0 );
+
+    std::vector< std::vector< int64_t > > nested( items / 16 );
+    size_t flat = 0;
+    for ( size_t i = 0; i < nested.size(); ++i )
+    {
+        size_t end = std::min( 16 * i + i % 32, items );
+        nested[ i ].assign( vec.begin() + 16 * i, vec.begin() + end );
+        flat += nested[ i ].size();
+    }
+
+    auto odd = []( int64_t x ) { return x % 2 != 0; };
+    auto sq = []( int64_t x ) { return x * x; };
+    auto affine = []( int64_t x ) { return 3 * x + 1; };
+    auto sparse = []( int64_t x ) { return x % 7 == 0; };
+
+    run( "map", items, rounds, [&] { return query::query( vec ).map( affine ); } );
+    run( "filter.map", items, rounds, [&] { return query::query( vec ).filter( odd ).map( sq ); } );
+    run( "map.filter.map", items, rounds,
+         [&] { return query::query( vec ).map( affine ).filter( sparse ).map( sq ); } );
+    run( "append.filter", 2 * items, rounds,
+         [&] { return query::query( vec ).append( query::range( vec ) ).filter( odd ); } );
+    run( "flatten.filter", flat, rounds, [&] { return query::query( nested ).flatten().filter( odd ); } );
+
+    for ( int64_t keys : { 16, 4096, 1'000'000 } )
+    {
+        group( "map", vec, keys, []( auto q, auto key ) { return q.groupBy( key ); } );
+        group( "hash", vec, keys, [=]( auto q, auto key ) { return q.hashGroupBy( key, keys ); } );
+    }
+}
@@ -0,0 +1,54 @@
+#include "brick-sql"
+#include "brick-unit"
+
+/* Only the parts which do not need a running server are tested here. */
+
+int main()
+{
+    using brq::sql::prepared_cache;
+
+    brq::test_case( "prepare_second" ) = []
+    {
+        prepared_cache c;
+        ASSERT( !c.find( "a" ) );
+        ASSERT( !c.repeated( "a" ) );
+        ASSERT( !c.repeated( "b" ) );
+        ASSERT( c.repeated( "a" ) );
+        ASSERT( !c.repeated( "a" ) ); /* forgotten once prepared */
+    };
+
+    brq::test_case( "seen_bounded" ) = []
+    {
+        prepared_cache c;
+        c.limit = 4;
+        for ( int i = 0; i < 100; ++i )
+        {
+            ASSERT( !c.repeated( std::string( brq::format( "select ", i ).data() ) ) );
+            ASSERT_LEQ( c._seen.size(), 4u );
+        }
+    };
+
+    brq::test_case( "lru" ) = []
+    {
+        prepared_cache c;
+        c.limit = 2;
+        std::string a = c.add( "a" ), b = c.add( "b" );
+        ASSERT_NEQ( a, b );
+        ASSERT_EQ( c.find( "a" ), a );      /* ‹b› is now the oldest */
+        ASSERT_EQ( c.evict(), b );
+        ASSERT( !c.find( "b" ) );
+        ASSERT_EQ( c.size(), 1u );
+
+        std::string d = c.add( "d" );
+        ASSERT_NEQ( d, a );                 /* names are never reused */
+        c.erase( "d" );
+        c.erase( "d" );                     /* erasing twice is harmless */
+        ASSERT_EQ( c.size(), 1u );
+        ASSERT_EQ( c.hits, 1u );
+        ASSERT_EQ( c.misses, 3u );
+
+        c.clear();
+        ASSERT_EQ( c.size(), 0u );
+        ASSERT( !c.find( "a" ) );
+    };
+}
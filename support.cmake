@@ -80,6 +80,23 @@ function( benchmark_bricks dir )
   target_link_libraries( benchmark-bricks pthread )
 endfunction()
 
+# Build a shared library which replaces the system malloc (and the global
+# operator new/delete) with brick-malloc when loaded via LD_PRELOAD. Use
+# bricks_malloc_preload( name directory_with_bricks ). The thread-local
+# allocator state is large, hence the initial-exec TLS model: the library is
+# not meant to be dlopen()-ed. Assertions are disabled, since evaluating
+# them may allocate, which would re-enter the interposed malloc.
+
+function( bricks_malloc_preload name dir )
+  set( file "${CMAKE_CURRENT_BINARY_DIR}/${name}.cpp" )
+  update_file( ${file} "#include <brick-malloc>" )
+  add_library( ${name} SHARED ${file} )
+  target_include_directories( ${name} PRIVATE ${dir} )
+  target_compile_definitions( ${name} PRIVATE BRICK_MALLOC_PRELOAD NDEBUG )
+  target_compile_options( ${name} PRIVATE -ftls-model=initial-exec -fno-builtin )
+  target_link_libraries( ${name} dl )
+endfunction()
+
 # Run feature checks and define -DBRICKS_* feature macros. You can use bricks
 # without feature checks, but you may be missing some of the features that
 # way. Calling this macro from your toplevel CMakeLists.txt is therefore a good